@@ -0,0 +1,206 @@
+// Small polyphonic wavetable mixer.
+// No Arduino dependencies so the same kernel builds on a Linux host (see tools/mixer_bench.cpp).
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <math.h>
+
+namespace Mixer
+{
+  static constexpr uint32_t SampleRate = 24000;
+  static constexpr int WaveBits = 8;
+  static constexpr int WaveLen = 1 << WaveBits;
+  static constexpr int MaxVoices = 6;
+  static constexpr int RampShift = 6;                   // 64-sample (~2.7 ms) attack/release, avoids clicks
+  static constexpr uint32_t RampSamples = 1u << RampShift;
+  static constexpr int ChunkSamples = 128;              // internal accumulator size (stack use)
+  static constexpr int16_t TableAmp = 16384;            // per-voice peak: half scale, headroom for overlaps
+  static constexpr int32_t LimitKnee = 16384;           // soft limiter: sums above this bend toward full scale
+
+  enum class Wave : uint8_t
+  {
+    Sine,   // same timbre as M5Unified tone()'s default sine table
+    Square, // odd harmonics 1..7 (band-limited), brighter than tone()
+  };
+
+  // Precomputed single-cycle tables, built once on first use
+  static inline const int16_t *wave_table(Wave w)
+  {
+    static int16_t square[WaveLen];
+    static int16_t sine[WaveLen];
+    static bool built = false;
+    if (!built)
+    {
+      for (int i = 0; i < WaveLen; ++i)
+      {
+        float ph = 2.0f * (float)M_PI * i / WaveLen;
+        float sq = sinf(ph) + sinf(3 * ph) / 3.0f + sinf(5 * ph) / 5.0f + sinf(7 * ph) / 7.0f;
+        square[i] = (int16_t)(sq * (TableAmp / 1.1f)); // partial sum peaks near 1.1
+        sine[i] = (int16_t)(sinf(ph) * TableAmp);
+      }
+      built = true;
+    }
+    return (w == Wave::Sine) ? sine : square;
+  }
+
+  struct Note
+  {
+    const int16_t *table = nullptr;
+    uint32_t step = 0;   // phase increment per sample (32-bit fixed point)
+    uint32_t delay = 0;  // samples of silence before the note starts
+    uint32_t length = 0; // note length in samples
+    uint16_t gain = 256; // Q8, 256 = unity
+  };
+
+  struct Voice : Note
+  {
+    uint32_t phase = 0;
+    uint32_t pos = 0;    // samples rendered since note start
+    bool active = false;
+    bool has_next = false;
+    Note next;           // starts once a stolen voice has faded out
+  };
+}
+
+class AudioMixer
+{
+public:
+  // Queue a note; delay_ms lets two-tone sounds be scheduled in one call site.
+  // Steals the most-finished voice when all slots are busy, fading it out first. Returns false for silent notes.
+  bool trigger(uint16_t freq, uint16_t ms, uint16_t delay_ms = 0, uint16_t gain = 256,
+               Mixer::Wave wave = Mixer::Wave::Sine)
+  {
+    if (!freq || !ms)
+      return false;
+    Mixer::Voice *v = nullptr;
+    for (auto &cand : voices_)
+    {
+      if (!cand.active)
+      {
+        v = &cand;
+        break;
+      }
+      if (!v || (uint64_t)cand.pos * v->length > (uint64_t)v->pos * cand.length) // further along
+        v = &cand;
+    }
+    Mixer::Note n;
+    n.table = Mixer::wave_table(wave);
+    n.step = (uint32_t)(((uint64_t)freq << 32) / Mixer::SampleRate);
+    n.delay = (uint32_t)delay_ms * Mixer::SampleRate / 1000;
+    n.length = (uint32_t)ms * Mixer::SampleRate / 1000;
+    if (n.length < 2 * Mixer::RampSamples)
+      n.length = 2 * Mixer::RampSamples;
+    n.gain = gain;
+    if (!v->active || v->delay)
+    {
+      start(*v, n); // silent so far; nothing to fade
+      return true;
+    }
+    // Cut the old note short through its release ramp, then start the new one
+    uint32_t fade = v->length - v->pos;
+    if (fade > Mixer::RampSamples)
+    {
+      fade = Mixer::RampSamples;
+      v->length = v->pos + fade;
+    }
+    n.delay = (n.delay > fade) ? n.delay - fade : 0;
+    v->next = n;
+    v->has_next = true;
+    return true;
+  }
+
+  bool active() const
+  {
+    for (const auto &v : voices_)
+      if (v.active)
+        return true;
+    return false;
+  }
+
+  void stop_all()
+  {
+    for (auto &v : voices_)
+      v.active = v.has_next = false;
+  }
+
+  // Mix all active voices into `out` (mono, signed 16-bit); pads with silence.
+  void render(int16_t *out, size_t n)
+  {
+    while (n > 0)
+    {
+      size_t chunk = n < (size_t)Mixer::ChunkSamples ? n : (size_t)Mixer::ChunkSamples;
+      int32_t acc[Mixer::ChunkSamples] = {};
+      for (auto &v : voices_)
+      {
+        if (v.active)
+          render_voice(v, acc, chunk);
+      }
+      for (size_t i = 0; i < chunk; ++i)
+        out[i] = limit(acc[i]);
+      out += chunk;
+      n -= chunk;
+    }
+  }
+
+private:
+  static void start(Mixer::Voice &v, const Mixer::Note &n)
+  {
+    static_cast<Mixer::Note &>(v) = n;
+    v.phase = 0;
+    v.pos = 0;
+    v.active = true;
+    v.has_next = false;
+  }
+
+  // Soft knee: identity up to LimitKnee, then approaches (never reaches) full scale
+  static int16_t limit(int32_t s)
+  {
+    const int32_t range = 32767 - Mixer::LimitKnee;
+    int32_t mag = s < 0 ? -s : s;
+    if (mag <= Mixer::LimitKnee)
+      return (int16_t)s;
+    int64_t over = mag - Mixer::LimitKnee;
+    mag = Mixer::LimitKnee + (int32_t)(over * range / (over + range));
+    return (int16_t)(s < 0 ? -mag : mag);
+  }
+
+  static void render_voice(Mixer::Voice &v, int32_t *acc, size_t n)
+  {
+    size_t i = 0;
+    while (i < n && v.active)
+    {
+      if (v.delay)
+      {
+        size_t skip = (v.delay < n - i) ? v.delay : n - i;
+        v.delay -= (uint32_t)skip;
+        i += skip;
+        continue;
+      }
+      const uint32_t tail = v.length - Mixer::RampSamples;
+      for (; i < n && v.pos < v.length; ++i, ++v.pos)
+      {
+        uint32_t env = 256;
+        if (v.pos < Mixer::RampSamples)
+          env = (v.pos << 8) >> Mixer::RampShift;
+        if (v.pos >= tail)
+        {
+          uint32_t rel = ((v.length - v.pos) << 8) >> Mixer::RampShift;
+          if (rel < env)
+            env = rel; // a note stolen during its attack fades from where it is
+        }
+        int32_t s = v.table[v.phase >> (32 - Mixer::WaveBits)];
+        acc[i] += (s * (int32_t)((v.gain * env) >> 8)) >> 8;
+        v.phase += v.step;
+      }
+      if (v.pos >= v.length)
+      {
+        if (v.has_next)
+          start(v, v.next);
+        else
+          v.active = false;
+      }
+    }
+  }
+
+  Mixer::Voice voices_[Mixer::MaxVoices];
+};
@@ -0,0 +1,249 @@
+// Synthetic input soak for `pio run -e bench` (-DBENCH_BUILD).
+// Scripted rotations, taps, drags, theme presses, long presses and starbursts drive the real drawing
+// code in a loop; per-effect frame cost, worst loop time and heap health are reported over Serial.
+#pragma once
+#include <Arduino.h>
+#include <esp_heap_caps.h>
+#include <math.h>
+#include "input_frame.h"
+
+namespace BenchCfg
+{
+  static constexpr uint32_t ReportMs = 10000;   // stats line interval
+  static constexpr uint32_t HeapSampleMs = 100; // largest-free-block walk is not free; sample it
+  static constexpr uint32_t DetentMs = 40;      // rotate: one detent per 40 ms, reverse every 10
+  static constexpr uint32_t TapEveryMs = 600;
+  static constexpr uint32_t TapDownMs = 80;
+  static constexpr uint32_t DragPeriodMs = 2000; // one lap of the drag circle
+  static constexpr int DragRadius = 70;
+  static constexpr uint32_t ThemeEveryMs = 300;
+  static constexpr uint32_t InvertEveryMs = 1500;
+  static constexpr uint32_t InvertDownMs = 1200;  // > LongPressInvertMs
+}
+
+// Effects double as script phases: each phase exercises one effect
+enum BenchEffect : uint8_t
+{
+  BenchRotate,
+  BenchTap,
+  BenchDrag,
+  BenchTheme,
+  BenchInvert,
+  BenchStarburst,
+  BenchEffectCount,
+  BenchNone = BenchEffectCount, // scope timed but not credited
+};
+
+static const char *const BENCH_NAMES[BenchEffectCount] = {"rotate", "tap/ping", "drag", "theme", "invert", "starburst"};
+static const uint32_t BENCH_PHASE_MS[BenchEffectCount] = {4000, 4000, 4000, 3000, 3000, 3000};
+// Effects paced by the script run for their whole phase; the rest mark themselves running
+static const bool BENCH_PHASE_PACED[BenchEffectCount] = {true, false, false, true, true, false};
+
+struct BenchStats
+{
+  uint32_t frames;
+  uint64_t render_us; // time inside the effect's draw calls
+  uint64_t wall_us;   // time the effect was running (loops it was active in)
+  uint32_t loops;
+  uint32_t worst_loop_us;
+};
+
+class Bench
+{
+public:
+  void begin(int cx, int cy, int enc_div)
+  {
+    cx_ = cx;
+    cy_ = cy;
+    enc_div_ = enc_div;
+    start_ms_ = cycle_ms_ = next_report_ms_ = millis();
+    next_report_ms_ += BenchCfg::ReportMs;
+    min_free_ = min_largest_ = UINT32_MAX;
+    sample_heap();
+    Serial.println("[BENCH] soak start");
+  }
+
+  // Fill `in` with the scripted input for this moment
+  void script(uint32_t now, InputFrame &in)
+  {
+    in = InputFrame();
+    uint32_t t = now - cycle_ms_;
+    int p = 0;
+    while (p < BenchEffectCount && t >= BENCH_PHASE_MS[p])
+      t -= BENCH_PHASE_MS[p++];
+    if (p == BenchEffectCount)
+    {
+      cycle_ms_ = now;
+      ++cycles_;
+      p = 0;
+      t = 0;
+    }
+    if (p != phase_)
+    {
+      phase_ = p;
+      last_tick_ = -1;
+    }
+    int32_t tick;
+    switch (phase_)
+    {
+    case BenchRotate:
+      tick = (int32_t)(t / BenchCfg::DetentMs);
+      if (tick != last_tick_)
+        in.enc_delta = ((tick / 10) % 2) ? -enc_div_ : enc_div_;
+      last_tick_ = tick;
+      break;
+    case BenchTap:
+      tick = (int32_t)(t / BenchCfg::TapEveryMs);
+      if (t % BenchCfg::TapEveryMs < BenchCfg::TapDownMs)
+      {
+        // Spread taps over the face with a cheap hash of the tap index
+        uint32_t h = (uint32_t)(tick + cycles_ * 16) * 2654435761u;
+        float a = (h & 0xFFFF) * (2.0f * (float)M_PI / 65536.0f);
+        int r = (int)((h >> 16) % 90);
+        touch(in, cx_ + (int)(cosf(a) * r), cy_ + (int)(sinf(a) * r));
+      }
+      break;
+    case BenchDrag:
+      if (t + 100 < BENCH_PHASE_MS[BenchDrag]) // lift before the phase ends so release runs
+      {
+        float a = 2.0f * (float)M_PI * (t % BenchCfg::DragPeriodMs) / BenchCfg::DragPeriodMs;
+        touch(in, cx_ + (int)(cosf(a) * BenchCfg::DragRadius), cy_ + (int)(sinf(a) * BenchCfg::DragRadius));
+      }
+      break;
+    case BenchTheme:
+      tick = (int32_t)(t / BenchCfg::ThemeEveryMs);
+      in.btn_pressed = (tick != last_tick_);
+      last_tick_ = tick;
+      break;
+    case BenchInvert:
+      if (t % BenchCfg::InvertEveryMs < BenchCfg::InvertDownMs)
+        touch(in, cx_, cy_);
+      break;
+    case BenchStarburst:
+      in.btn_hold = (last_tick_ < 0);
+      last_tick_ = 0;
+      break;
+    }
+  }
+
+  void loop_begin() { loop_t0_ = micros(); }
+
+  void loop_end(uint32_t now)
+  {
+    uint32_t t1 = micros();
+    uint32_t dt = t1 - loop_t0_;
+    BenchStats &s = stats_[phase_];
+    s.loops++;
+    if (!commit_in_loop_ && dt > s.worst_loop_us) // commits are reported on their own line
+      s.worst_loop_us = dt;
+    commit_in_loop_ = false;
+    // Wall time since the previous loop ended goes to every effect running in this loop
+    if (BENCH_PHASE_PACED[phase_])
+      running_[phase_] = true;
+    uint32_t wall = last_loop_end_us_ ? t1 - last_loop_end_us_ : dt;
+    last_loop_end_us_ = t1;
+    for (int e = 0; e < BenchEffectCount; ++e)
+    {
+      if (running_[e])
+        stats_[e].wall_us += wall;
+      running_[e] = false;
+    }
+    if (now - last_heap_ms_ >= BenchCfg::HeapSampleMs)
+      sample_heap();
+    if ((int32_t)(now - next_report_ms_) >= 0)
+    {
+      next_report_ms_ += BenchCfg::ReportMs;
+      report(now);
+    }
+  }
+
+  void running(BenchEffect e)
+  {
+    if (e < BenchEffectCount)
+      running_[e] = true;
+  }
+
+  void frame(BenchEffect e, uint32_t us, uint32_t frames)
+  {
+    if (e >= BenchEffectCount)
+      return;
+    stats_[e].frames += frames;
+    stats_[e].render_us += us;
+    running_[e] = true;
+  }
+
+  // Settings NVS commits (bench namespace); kept out of the per-phase worst loop times
+  void settings_commit(uint32_t us)
+  {
+    commit_in_loop_ = true;
+    commits_++;
+    last_commit_us_ = us;
+    if (us > max_commit_us_)
+      max_commit_us_ = us;
+  }
+
+private:
+  static void touch(InputFrame &in, int x, int y)
+  {
+    in.touch_count = 1;
+    in.x = (int16_t)x;
+    in.y = (int16_t)y;
+  }
+
+  void sample_heap()
+  {
+    last_heap_ms_ = millis();
+    free_ = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    largest_ = heap_caps_get_largest_free_block(MALLOC_CAP_8BIT);
+    if (free_ < min_free_)
+      min_free_ = free_;
+    if (largest_ < min_largest_)
+      min_largest_ = largest_;
+  }
+
+  void report(uint32_t now)
+  {
+    // min_free is our sampled low; watermark is the allocator's own all-time minimum
+    Serial.printf("[BENCH] t=%lus cycles=%lu heap free=%lu min=%lu watermark=%lu largest=%lu min_largest=%lu\n",
+                  (unsigned long)((now - start_ms_) / 1000), (unsigned long)cycles_,
+                  (unsigned long)free_, (unsigned long)min_free_,
+                  (unsigned long)heap_caps_get_minimum_free_size(MALLOC_CAP_8BIT),
+                  (unsigned long)largest_, (unsigned long)min_largest_);
+    for (int e = 0; e < BenchEffectCount; ++e)
+    {
+      const BenchStats &s = stats_[e];
+      // fps = frames achieved per second the effect was running; avg = render cost per frame
+      float fps = s.wall_us ? (float)s.frames * 1e6f / (float)s.wall_us : 0.0f;
+      uint32_t avg = s.frames ? (uint32_t)(s.render_us / s.frames) : 0;
+      Serial.printf("[BENCH]   %-9s frames=%lu avg=%luus fps=%.1f loops=%lu worst_loop=%luus\n",
+                    BENCH_NAMES[e], (unsigned long)s.frames, (unsigned long)avg, fps,
+                    (unsigned long)s.loops, (unsigned long)s.worst_loop_us);
+    }
+    Serial.printf("[BENCH]   settings  commits=%lu last=%luus max=%luus\n", (unsigned long)commits_,
+                  (unsigned long)last_commit_us_, (unsigned long)max_commit_us_);
+  }
+
+  int cx_ = 120, cy_ = 120, enc_div_ = 4;
+  int phase_ = 0;
+  int32_t last_tick_ = -1;
+  uint32_t cycles_ = 0;
+  uint32_t start_ms_ = 0, cycle_ms_ = 0, next_report_ms_ = 0, last_heap_ms_ = 0;
+  uint32_t loop_t0_ = 0, last_loop_end_us_ = 0;
+  bool running_[BenchEffectCount] = {};
+  bool commit_in_loop_ = false;
+  uint32_t commits_ = 0, last_commit_us_ = 0, max_commit_us_ = 0;
+  uint32_t free_ = 0, largest_ = 0, min_free_ = 0, min_largest_ = 0;
+  BenchStats stats_[BenchEffectCount] = {};
+};
+
+static Bench bench;
+
+// Times one draw call site and credits it to an effect
+struct BenchScope
+{
+  BenchEffect effect;
+  uint32_t frames;
+  uint32_t t0;
+  explicit BenchScope(BenchEffect e, uint32_t n = 1) : effect(e), frames(n), t0(micros()) {}
+  ~BenchScope() { bench.frame(effect, micros() - t0, frames); }
+};
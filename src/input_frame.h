@@ -0,0 +1,12 @@
+// One loop's worth of input (hardware, or the scripted soak in the bench build)
+#pragma once
+#include <stdint.h>
+
+struct InputFrame
+{
+  int32_t enc_delta;
+  int touch_count;
+  int16_t x, y; // first touch point
+  bool btn_pressed;
+  bool btn_hold;
+};
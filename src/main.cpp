@@ -5,6 +5,17 @@
 #include <algorithm>
 #include <cstdio>
 #include <math.h>
+#include "audio_mixer.h"
+#include "settings_store.h"
+#include "input_frame.h"
+#ifdef BENCH_BUILD
+#include "bench.h"
+#define BENCH_SCOPE(...) BenchScope bench_scope_(__VA_ARGS__)
+#define BENCH_RUNNING(e) bench.running(e)
+#else
+#define BENCH_SCOPE(...) ((void)0)
+#define BENCH_RUNNING(e) ((void)0)
+#endif
 
 static inline uint16_t rgb(uint8_t r, uint8_t g, uint8_t b)
 {
@@ -26,6 +37,7 @@ namespace Config
   // Rotary encoder / brightness
   static constexpr int BrightMax = 100;
   static constexpr int BrightStep = 10; // percent per detent
+  static constexpr int BrightBootMin = 10; // restored brightness floor, so a 0% save doesn't boot to black
   static constexpr int EncDiv = 4;     // counts per logical step
 
   // Audio: click on rotation
@@ -64,7 +76,23 @@ namespace Config
   static constexpr uint16_t TapPop1Ms = 50;
   static constexpr uint16_t TapPop2Ms = 60;
   static constexpr uint16_t TapPopGapMs = 60;
-  static constexpr uint8_t SpeakerVolume = 180;
+  static constexpr uint8_t SpeakerVolume = 255; // mixer voices are half scale (headroom); make up level here
+
+  // Audio mixer: a task queues mixed blocks on one speaker channel (I2S DMA runs inside M5Unified)
+  static constexpr uint8_t AudioChannel = 0;
+  static constexpr int AudioBlockSamples = 256; // ~10.7 ms at Mixer::SampleRate
+  static constexpr int AudioBlocks = 3;         // one playing, one queued, one being mixed
+  static constexpr uint32_t AudioTaskPeriodMs = 4; // refill poll; well under one block
+  static constexpr uint32_t AudioTaskStack = 3072;
+  static constexpr UBaseType_t AudioTaskPriority = 2; // above loopTask (1) so drawing can't starve it
+  static constexpr BaseType_t AudioTaskCore = 1;
+
+  // Persistent settings (brightness, theme, invert); commit timing lives in SettingsCfg
+#ifdef BENCH_BUILD
+  static constexpr const char *SettingsNamespace = "dial-bench"; // soak never overwrites the user's settings
+#else
+  static constexpr const char *SettingsNamespace = "dial";
+#endif
 
   // Touch / gestures
   static constexpr uint16_t TouchHoldThreshMs = 1000;
@@ -96,12 +124,14 @@ namespace Config
   static constexpr bool DebugBtn = false;
   static constexpr bool DebugRot = false;
   static constexpr bool DebugPing = false;
+  static constexpr bool DebugSettings = false;
 #else
   static constexpr bool DebugTouch = true;
   static constexpr bool DebugHeartbeat = false;
   static constexpr bool DebugBtn = true;
   static constexpr bool DebugRot = true;
   static constexpr bool DebugPing = true;
+  static constexpr bool DebugSettings = true;
 #endif
 }
 
@@ -145,9 +175,18 @@ static constexpr uint16_t CONF_TONE1_MS = 70;     // first tone length
 static constexpr uint16_t CONF_TONE2_MS = 90;     // second tone length
 static constexpr uint16_t CONF_TONE_GAP_MS = 80;  // gap between tones
 
-static uint32_t tone2_at = 0;
-static uint16_t tone2_freq = 0;
-static uint16_t tone2_dur = 0;
+// Software mixer feeding the speaker from its own task; effects overlap instead of cutting each other off
+static AudioMixer mixer;
+static int16_t audio_buf[Config::AudioBlocks][Config::AudioBlockSamples];
+static int audio_buf_next = 0;
+static SemaphoreHandle_t audio_lock = nullptr;
+static TaskHandle_t audio_task_handle = nullptr;
+
+// Settings persisted to NVS after a quiet period (see settings_store.h)
+static uint32_t clock_us() { return (uint32_t)micros(); }
+static NvsSettingsBackend settings_nvs;
+static SettingsStore settings(settings_nvs, clock_us);
+static bool settings_ok = false; // NVS namespace opened; otherwise settings stay RAM-only
 
 static uint32_t press_start_ms = 0;
 static int16_t press_x0 = 0, press_y0 = 0;
@@ -184,6 +223,11 @@ static void play_confirm_down();
 static void play_invert();
 static void effect_starburst();
 static void play_invert();
+static void audio_begin();
+static void play_tone(uint16_t freq, uint16_t ms, uint16_t delay_ms = 0);
+static void settings_restore();
+static void settings_changed();
+static void read_input(InputFrame &in);
 
 void setup()
 {
@@ -213,26 +257,40 @@ void setup()
   cross_prev_cy = cross_cy;
   cross_initialized = true;
 
+  // Restore brightness/theme/invert before the first frame
+  settings_restore();
+
   M5Dial.Display.fillScreen(THEMES[theme_idx].bg);
   draw_scene(true);
 
   M5Dial.Speaker.setVolume(Config::SpeakerVolume);
+  audio_begin();
   if (!mute)
-    M5Dial.Speaker.tone(2000, 200);
+    play_tone(2000, 200);
 
   M5Dial.Encoder.readAndReset();
+#ifdef BENCH_BUILD
+  bench.begin(cx, cy, Config::EncDiv);
+#endif
 }
 
 void loop()
 {
+#ifdef BENCH_BUILD
+  bench.loop_begin();
+#endif
   M5.update();
   M5Dial.update();
+  InputFrame in;
+  read_input(in);
+  if (in.enc_delta || in.touch_count || in.btn_pressed || in.btn_hold)
+    settings.activity(millis());
 
   constexpr int BRIGHT_MAX = Config::BrightMax;
   constexpr int BRIGHT_STEP = Config::BrightStep; // percent per detent
 
   // Encoder → brightness
-  int32_t d = M5Dial.Encoder.readAndReset();
+  int32_t d = in.enc_delta;
   if (d)
     enc_accum += d;
   int logical = 0;
@@ -257,10 +315,11 @@ void loop()
       brightness_pct = BRIGHT_MAX;
     int mapped = (brightness_pct * 255) / BRIGHT_MAX;
     M5Dial.Display.setBrightness(mapped);
+    settings_changed();
     // Immediate click sound: higher pitch when increasing, lower when decreasing
     if (!mute && brightness_pct != prev_b)
     {
-      M5Dial.Speaker.tone((brightness_pct > prev_b) ? Config::ClickUpFreq : Config::ClickDownFreq, Config::ClickMs);
+      play_tone((brightness_pct > prev_b) ? Config::ClickUpFreq : Config::ClickDownFreq, Config::ClickMs);
     }
     if (Config::DebugRot && brightness_pct != prev_b)
     {
@@ -268,21 +327,21 @@ void loop()
       if (delta < 0) delta = -delta;
       Serial.printf("[ROT] %s%d%% -> br=%d%%\n", (brightness_pct > prev_b) ? "+" : "-", delta, brightness_pct);
     }
+    BENCH_SCOPE(BenchRotate);
     draw_ring(false);
   }
 
   // Touch handling with robust state (works even if edge events are missed)
-  int touch_count = M5Dial.Touch.getCount();
+  int touch_count = in.touch_count;
   if (touch_count > 0)
   {
-    const auto &t = M5Dial.Touch.getDetail(0);
     if (!touch_active)
     {
-      press_start_ms = millis(); press_x0 = t.x; press_y0 = t.y; touch_dragged = false; touch_active = true;
-      if (Config::DebugTouch) Serial.printf("[TOUCH] PRESS x=%d y=%d\n", t.x, t.y);
+      press_start_ms = millis(); press_x0 = in.x; press_y0 = in.y; touch_dragged = false; touch_active = true;
+      if (Config::DebugTouch) Serial.printf("[TOUCH] PRESS x=%d y=%d\n", in.x, in.y);
     }
-    touch_last_x = t.x; touch_last_y = t.y;
-    int mdx0 = t.x - press_x0; int mdy0 = t.y - press_y0; uint32_t move02 = (uint32_t)(mdx0*mdx0 + mdy0*mdy0);
+    touch_last_x = in.x; touch_last_y = in.y;
+    int mdx0 = in.x - press_x0; int mdy0 = in.y - press_y0; uint32_t move02 = (uint32_t)(mdx0*mdx0 + mdy0*mdy0);
     if (!touch_dragged)
     {
       uint32_t maxmove2 = (uint32_t)Config::TapMaxMovePx * (uint32_t)Config::TapMaxMovePx;
@@ -292,9 +351,10 @@ void loop()
       }
     }
     // Update center label (so X,Y updates live), then overlay crosshair on top
+    BENCH_SCOPE(touch_dragged ? BenchDrag : BenchNone); // taps and long-press holds aren't drags
     draw_center_label();
-    int txi = t.x; if (txi < 0) txi = 0; int maxx = M5Dial.Display.width() - 1; if (txi > maxx) txi = maxx;
-    int tyi = t.y; if (tyi < 0) tyi = 0; int maxy = M5Dial.Display.height() - 1; if (tyi > maxy) tyi = maxy;
+    int txi = in.x; if (txi < 0) txi = 0; int maxx = M5Dial.Display.width() - 1; if (txi > maxx) txi = maxx;
+    int tyi = in.y; if (tyi < 0) tyi = 0; int maxy = M5Dial.Display.height() - 1; if (tyi > maxy) tyi = maxy;
     draw_crosshair_overlay((int16_t)txi, (int16_t)tyi);
   }
   else if (touch_active)
@@ -305,7 +365,8 @@ void loop()
     uint32_t maxmove2 = (uint32_t)Config::TapMaxMovePx * (uint32_t)Config::TapMaxMovePx;
     if (!touch_dragged && dur > Config::LongPressInvertMs)
     {
-      invert_latched = !invert_latched; M5Dial.Display.invertDisplay(invert_latched);
+      BENCH_SCOPE(BenchInvert);
+      invert_latched = !invert_latched; M5Dial.Display.invertDisplay(invert_latched); settings_changed();
       if (!mute) play_invert();
       if (Config::DebugTouch) Serial.printf("[TOUCH] RELEASE dur=%lu invert (no-drag)\n", (unsigned long)dur);
     }
@@ -316,6 +377,7 @@ void loop()
     }
     else
     {
+      BENCH_SCOPE(BenchDrag); // full ring redraw: the costliest drag frame
       draw_ring(true);
       if (Config::DebugTouch) Serial.printf("[TOUCH] RELEASE dur=%lu drag refresh\n", (unsigned long)dur);
     }
@@ -323,8 +385,11 @@ void loop()
   }
 
   // Target ping animation (expanding circle overlay with background restore)
+  if (ripple_active)
+    BENCH_RUNNING(BenchTap);
   if (ripple_active && millis() >= ripple_redraw_at)
   {
+    BENCH_SCOPE(BenchTap);
     auto &t = THEMES[theme_idx];
     // Restore previous frame background
     if (ping_bk && ping_w > 0 && ping_h > 0)
@@ -396,28 +461,33 @@ void loop()
   }
 
   // BtnA: press cycles theme immediately; hold triggers starburst effect
-  if (M5Dial.BtnA.wasPressed())
+  if (in.btn_pressed)
   {
+    BENCH_SCOPE(BenchTheme);
     theme_idx = (theme_idx + 1) % (int)(sizeof(THEMES) / sizeof(THEMES[0]));
     draw_scene(true);
+    settings_changed();
     play_confirm_up();
     if (Config::DebugBtn) Serial.printf("[BTN] A press -> theme %d\n", theme_idx+1);
   }
-  if (M5Dial.BtnA.wasHold())
+  if (in.btn_hold)
   {
     if (Config::DebugBtn) Serial.println("[BTN] A hold -> starburst");
+    BENCH_SCOPE(BenchStarburst, Config::StarburstSteps * 2 + 1);
     effect_starburst();
   }
 
-  // Timed secondary tones (confirmation sounds)
-  uint32_t now = millis();
-  if (tone2_at && now >= tone2_at)
+  // Write coalesced settings once input has gone quiet
+  if (settings_ok && settings.service(millis()))
   {
-    if (!mute && tone2_freq)
-      M5Dial.Speaker.tone(tone2_freq, tone2_dur);
-    tone2_at = 0;
-    tone2_freq = 0;
-    tone2_dur = 0;
+    const auto &st = settings.stats();
+#ifdef BENCH_BUILD
+    bench.settings_commit(st.last_commit_us);
+#endif
+    if (Config::DebugSettings)
+      Serial.printf("[SETTINGS] commit #%lu (%lu changes) took %luus max=%luus\n",
+                    (unsigned long)st.commits, (unsigned long)st.changes,
+                    (unsigned long)st.last_commit_us, (unsigned long)st.max_commit_us);
   }
 
   // Debug heartbeat
@@ -430,6 +500,28 @@ void loop()
                   (int)touch_active, (int)touch_dragged,
                   cross_cx, cross_cy, (int)invert_latched);
   }
+#ifdef BENCH_BUILD
+  bench.loop_end(millis());
+#endif
+}
+
+static void read_input(InputFrame &in)
+{
+#ifdef BENCH_BUILD
+  bench.script(millis(), in);
+#else
+  in.enc_delta = M5Dial.Encoder.readAndReset();
+  in.touch_count = M5Dial.Touch.getCount();
+  in.x = in.y = 0;
+  if (in.touch_count > 0)
+  {
+    const auto &t = M5Dial.Touch.getDetail(0);
+    in.x = t.x;
+    in.y = t.y;
+  }
+  in.btn_pressed = M5Dial.BtnA.wasPressed();
+  in.btn_hold = M5Dial.BtnA.wasHold();
+#endif
 }
 
 static void draw_status()
@@ -581,10 +673,8 @@ static void play_pop()
 {
   if (mute)
     return;
-  M5Dial.Speaker.tone(Config::TapPop1Freq, Config::TapPop1Ms);
-  tone2_at = millis() + Config::TapPopGapMs;
-  tone2_freq = Config::TapPop2Freq;
-  tone2_dur = Config::TapPop2Ms;
+  play_tone(Config::TapPop1Freq, Config::TapPop1Ms);
+  play_tone(Config::TapPop2Freq, Config::TapPop2Ms, Config::TapPopGapMs);
 }
 
 static void play_confirm_up()
@@ -592,10 +682,8 @@ static void play_confirm_up()
   if (mute)
     return;
   // Ascending chirp: lower (down) then higher (up)
-  M5Dial.Speaker.tone(Config::ConfirmToneDownFreq, Config::ConfirmTone1Ms);
-  tone2_at = millis() + Config::ConfirmToneGapMs;
-  tone2_freq = Config::ConfirmToneUpFreq;
-  tone2_dur = Config::ConfirmTone2Ms;
+  play_tone(Config::ConfirmToneDownFreq, Config::ConfirmTone1Ms);
+  play_tone(Config::ConfirmToneUpFreq, Config::ConfirmTone2Ms, Config::ConfirmToneGapMs);
 }
 
 static void play_confirm_down()
@@ -603,10 +691,8 @@ static void play_confirm_down()
   if (mute)
     return;
   // Descending chirp: higher (up) then lower (down)
-  M5Dial.Speaker.tone(Config::ConfirmToneUpFreq, Config::ConfirmTone1Ms);
-  tone2_at = millis() + Config::ConfirmToneGapMs;
-  tone2_freq = Config::ConfirmToneDownFreq;
-  tone2_dur = Config::ConfirmTone2Ms;
+  play_tone(Config::ConfirmToneUpFreq, Config::ConfirmTone1Ms);
+  play_tone(Config::ConfirmToneDownFreq, Config::ConfirmTone2Ms, Config::ConfirmToneGapMs);
 }
 
 // moved below with other effect functions
@@ -621,10 +707,8 @@ static void effect_starburst()
 
   // Optional: small upbeat chirp
   if (!mute) {
-    M5Dial.Speaker.tone(Config::StarburstTone1Freq, Config::StarburstTone1Ms);
-    tone2_at = millis() + Config::StarburstToneGapMs;
-    tone2_freq = Config::StarburstTone2Freq;
-    tone2_dur = Config::StarburstTone2Ms;
+    play_tone(Config::StarburstTone1Freq, Config::StarburstTone1Ms);
+    play_tone(Config::StarburstTone2Freq, Config::StarburstTone2Ms, Config::StarburstToneGapMs);
   }
   if (Config::DebugBtn) Serial.println("[EFFECT] Starburst start");
 
@@ -693,8 +777,61 @@ static void play_invert()
   if (mute)
     return;
   // Two-tone "be-boop" for invert
-  M5Dial.Speaker.tone(Config::InvertTone1Freq, Config::InvertTone1Ms);
-  tone2_at = millis() + Config::InvertToneGapMs;
-  tone2_freq = Config::InvertTone2Freq;
-  tone2_dur = Config::InvertTone2Ms;
+  play_tone(Config::InvertTone1Freq, Config::InvertTone1Ms);
+  play_tone(Config::InvertTone2Freq, Config::InvertTone2Ms, Config::InvertToneGapMs);
+}
+
+static void audio_task(void *)
+{
+  // Top up the channel's two-slot queue; wakes early when a tone is queued from idle
+  for (;;)
+  {
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(Config::AudioTaskPeriodMs));
+    xSemaphoreTake(audio_lock, portMAX_DELAY);
+    while (mixer.active() && M5Dial.Speaker.isPlaying(Config::AudioChannel) < 2)
+    {
+      int16_t *buf = audio_buf[audio_buf_next];
+      audio_buf_next = (audio_buf_next + 1) % Config::AudioBlocks;
+      mixer.render(buf, Config::AudioBlockSamples);
+      M5Dial.Speaker.playRaw(buf, Config::AudioBlockSamples, Mixer::SampleRate, false, 1, Config::AudioChannel, false);
+    }
+    xSemaphoreGive(audio_lock);
+  }
+}
+
+static void audio_begin()
+{
+  audio_lock = xSemaphoreCreateMutex();
+  xTaskCreatePinnedToCore(audio_task, "audio", Config::AudioTaskStack, nullptr, Config::AudioTaskPriority,
+                          &audio_task_handle, Config::AudioTaskCore);
+}
+
+static void play_tone(uint16_t freq, uint16_t ms, uint16_t delay_ms)
+{
+  xSemaphoreTake(audio_lock, portMAX_DELAY);
+  mixer.trigger(freq, ms, delay_ms);
+  xSemaphoreGive(audio_lock);
+  xTaskNotifyGive(audio_task_handle);
+}
+
+static void settings_restore()
+{
+  Settings s = {(uint8_t)brightness_pct, (uint8_t)theme_idx, (uint8_t)invert_latched};
+  settings_ok = settings_nvs.begin(Config::SettingsNamespace);
+  bool found = settings_ok && settings.restore(s);
+  const int themes = (int)(sizeof(THEMES) / sizeof(THEMES[0]));
+  brightness_pct = std::max(Config::BrightBootMin, std::min((int)s.brightness_pct, Config::BrightMax));
+  theme_idx = (s.theme_idx < themes) ? s.theme_idx : 0;
+  invert_latched = s.invert != 0;
+  M5Dial.Display.setBrightness((brightness_pct * 255) / Config::BrightMax);
+  M5Dial.Display.invertDisplay(invert_latched);
+  if (Config::DebugSettings)
+    Serial.printf("[SETTINGS] %s br=%d%% theme=%d inv=%d\n", found ? "restored" : "defaults",
+                  brightness_pct, theme_idx + 1, (int)invert_latched);
+}
+
+static void settings_changed()
+{
+  Settings s = {(uint8_t)brightness_pct, (uint8_t)theme_idx, (uint8_t)invert_latched};
+  settings.set(s, millis());
 }
@@ -0,0 +1,201 @@
+// Persistent settings with write coalescing.
+// Changes stay in RAM and are committed only after a quiet period, so flash writes never land in the
+// encoder path. Records rotate across a few slots (wear-leveling on top of NVS) and carry a format
+// version, sequence number and CRC; boot restores the newest valid one.
+// The store itself has no Arduino dependencies; NVS access goes through SettingsBackend.
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+namespace SettingsCfg
+{
+  static constexpr uint8_t RecordVersion = 1;
+  static constexpr int Slots = 4;                 // records rotate across rec0..rec3
+  static constexpr uint32_t QuietMs = 2000;       // commit after this long without changes or input
+}
+
+struct Settings
+{
+  uint8_t brightness_pct;
+  uint8_t theme_idx;
+  uint8_t invert;
+};
+
+struct SettingsRecord
+{
+  uint8_t version;
+  uint8_t brightness_pct;
+  uint8_t theme_idx;
+  uint8_t invert;
+  uint32_t seq;
+  uint32_t crc; // over all preceding bytes
+};
+
+// Key/blob storage (NVS on device, a file on the host)
+class SettingsBackend
+{
+public:
+  virtual ~SettingsBackend() {}
+  virtual bool read(const char *key, void *buf, size_t len) = 0;
+  virtual bool write(const char *key, const void *buf, size_t len) = 0;
+};
+
+struct SettingsStats
+{
+  uint32_t changes = 0;        // set() calls that changed a value
+  uint32_t commits = 0;        // records written
+  uint32_t failed = 0;         // backend write failures
+  uint32_t last_commit_us = 0;
+  uint32_t max_commit_us = 0;
+};
+
+class SettingsStore
+{
+public:
+  typedef uint32_t (*ClockUs)();
+
+  SettingsStore(SettingsBackend &backend, ClockUs clock_us) : backend_(backend), clock_us_(clock_us) {}
+
+  // Load the newest valid record into `out`; leaves `out` untouched (defaults) if none found.
+  bool restore(Settings &out)
+  {
+    bool found = false;
+    for (int i = 0; i < SettingsCfg::Slots; ++i)
+    {
+      SettingsRecord r;
+      char key[8];
+      slot_key(i, key);
+      if (!backend_.read(key, &r, sizeof(r)))
+        continue;
+      if (r.version != SettingsCfg::RecordVersion || r.crc != crc32(&r, offsetof(SettingsRecord, crc)))
+        continue;
+      if (!found || (int32_t)(r.seq - seq_) > 0)
+      {
+        seq_ = r.seq;
+        out.brightness_pct = r.brightness_pct;
+        out.theme_idx = r.theme_idx;
+        out.invert = r.invert;
+        found = true;
+      }
+    }
+    current_ = committed_ = out;
+    dirty_ = false;
+    return found;
+  }
+
+  // Record a change in RAM only; cheap enough to call on every detent.
+  void set(const Settings &s, uint32_t now_ms)
+  {
+    if (same(s, current_))
+      return;
+    current_ = s;
+    stats_.changes++;
+    dirty_ = !same(current_, committed_);
+    quiet_since_ms_ = now_ms;
+  }
+
+  // Any user input restarts the quiet period, so a commit (which may erase a flash sector and
+  // stalls both cores) never lands in the middle of an interaction or its animation.
+  void activity(uint32_t now_ms) { quiet_since_ms_ = now_ms; }
+
+  // Commit once the device has been idle for QuietMs. Returns true if a record was written.
+  bool service(uint32_t now_ms)
+  {
+    if (!dirty_ || now_ms - quiet_since_ms_ < SettingsCfg::QuietMs)
+      return false;
+    return commit(now_ms);
+  }
+
+  bool commit(uint32_t now_ms)
+  {
+    SettingsRecord r;
+    memset(&r, 0, sizeof(r));
+    r.version = SettingsCfg::RecordVersion;
+    r.brightness_pct = current_.brightness_pct;
+    r.theme_idx = current_.theme_idx;
+    r.invert = current_.invert;
+    r.seq = seq_ + 1;
+    r.crc = crc32(&r, offsetof(SettingsRecord, crc));
+    char key[8];
+    slot_key((int)(r.seq % SettingsCfg::Slots), key);
+    uint32_t t0 = clock_us_();
+    bool ok = backend_.write(key, &r, sizeof(r));
+    uint32_t dt = clock_us_() - t0;
+    stats_.last_commit_us = dt;
+    if (dt > stats_.max_commit_us)
+      stats_.max_commit_us = dt;
+    if (!ok)
+    {
+      stats_.failed++;
+      quiet_since_ms_ = now_ms; // stay dirty; retry after another quiet period, not every loop
+      return false;
+    }
+    seq_ = r.seq;
+    committed_ = current_;
+    dirty_ = false;
+    stats_.commits++;
+    return true;
+  }
+
+  bool dirty() const { return dirty_; }
+  const SettingsStats &stats() const { return stats_; }
+
+private:
+  static bool same(const Settings &a, const Settings &b)
+  {
+    return a.brightness_pct == b.brightness_pct && a.theme_idx == b.theme_idx && a.invert == b.invert;
+  }
+
+  static void slot_key(int i, char *key)
+  {
+    memcpy(key, "rec0", 5);
+    key[3] = (char)('0' + i);
+  }
+
+  static uint32_t crc32(const void *data, size_t len)
+  {
+    const uint8_t *p = (const uint8_t *)data;
+    uint32_t c = 0xFFFFFFFFu;
+    for (size_t i = 0; i < len; ++i)
+    {
+      c ^= p[i];
+      for (int k = 0; k < 8; ++k)
+        c = (c >> 1) ^ (0xEDB88320u & (0u - (c & 1u)));
+    }
+    return ~c;
+  }
+
+  SettingsBackend &backend_;
+  ClockUs clock_us_;
+  Settings current_ = {};
+  Settings committed_ = {};
+  uint32_t seq_ = 0;
+  uint32_t quiet_since_ms_ = 0;
+  bool dirty_ = false;
+  SettingsStats stats_;
+};
+
+#ifdef ARDUINO
+#include <Preferences.h>
+
+// NVS-backed storage via the Arduino Preferences wrapper (one namespace, kept open)
+class NvsSettingsBackend : public SettingsBackend
+{
+public:
+  bool begin(const char *ns) { return prefs_.begin(ns, false); }
+  bool read(const char *key, void *buf, size_t len) override
+  {
+    if (!prefs_.isKey(key) || prefs_.getBytesLength(key) != len)
+      return false;
+    return prefs_.getBytes(key, buf, len) == len;
+  }
+  bool write(const char *key, const void *buf, size_t len) override
+  {
+    return prefs_.putBytes(key, buf, len) == len;
+  }
+
+private:
+  Preferences prefs_;
+};
+#endif
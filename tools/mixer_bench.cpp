@@ -0,0 +1,155 @@
+// Host benchmark for the wavetable mixer in src/audio_mixer.h.
+// Renders the demo's effect sounds (overlapping), times the mixing kernel and writes a WAV for listening.
+//
+// Build/run on Linux:
+//   g++ -O2 -std=c++11 -Isrc tools/mixer_bench.cpp -o mixer_bench && ./mixer_bench mixer_bench.wav
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "audio_mixer.h"
+
+static constexpr int BlockSamples = 256; // matches Config::AudioBlockSamples in main.cpp
+
+static void write_u32(FILE *f, uint32_t v) { fwrite(&v, 4, 1, f); }
+static void write_u16(FILE *f, uint16_t v) { fwrite(&v, 2, 1, f); }
+
+static bool write_wav(const char *path, const std::vector<int16_t> &pcm)
+{
+  FILE *f = fopen(path, "wb");
+  if (!f)
+    return false;
+  uint32_t data_bytes = (uint32_t)(pcm.size() * sizeof(int16_t));
+  fwrite("RIFF", 1, 4, f);
+  write_u32(f, 36 + data_bytes);
+  fwrite("WAVEfmt ", 1, 8, f);
+  write_u32(f, 16);
+  write_u16(f, 1); // PCM
+  write_u16(f, 1); // mono
+  write_u32(f, Mixer::SampleRate);
+  write_u32(f, Mixer::SampleRate * 2);
+  write_u16(f, 2);
+  write_u16(f, 16);
+  fwrite("data", 1, 4, f);
+  write_u32(f, data_bytes);
+  fwrite(pcm.data(), sizeof(int16_t), pcm.size(), f);
+  fclose(f);
+  return true;
+}
+
+struct DemoNote
+{
+  uint32_t at_ms; // when play_*() would fire
+  uint16_t freq, ms, delay_ms;
+};
+
+// Same tones as main.cpp's Config, fired close together so they overlap;
+// the rotary click burst pushes past MaxVoices so voices get stolen mid-note
+static const DemoNote DEMO[] = {
+    {0, 1200, 50, 0},   {0, 1800, 60, 60},     // tap pop
+    {40, 1200, 70, 0},  {40, 1800, 90, 80},    // confirm up
+    {90, 1800, 40, 0},  {100, 1000, 40, 0},    // rotary clicks
+    {110, 1800, 40, 0}, {120, 1000, 40, 0},
+    {130, 1800, 40, 0}, {140, 1000, 40, 0},
+    {150, 900, 80, 0},  {150, 600, 100, 70},   // invert be-boop
+    {200, 1500, 60, 0}, {200, 2100, 70, 50},   // starburst
+};
+
+// Renders the demo schedule 1 ms at a time
+static void render_demo(AudioMixer &m, std::vector<int16_t> &pcm)
+{
+  const size_t per_ms = Mixer::SampleRate / 1000;
+  int16_t block[Mixer::SampleRate / 1000];
+  size_t next = 0;
+  const size_t count = sizeof(DEMO) / sizeof(DEMO[0]);
+  for (uint32_t t = 0; next < count || m.active(); ++t)
+  {
+    for (; next < count && DEMO[next].at_ms <= t; ++next)
+      m.trigger(DEMO[next].freq, DEMO[next].ms, DEMO[next].delay_ms);
+    m.render(block, per_ms);
+    pcm.insert(pcm.end(), block, block + per_ms);
+  }
+}
+
+// Largest sample-to-sample jump when a sounding voice is stolen at its peak; a hard cut steps by ~TableAmp
+static int steal_step()
+{
+  AudioMixer m;
+  int16_t buf[1024];
+  m.trigger(100, 1000);        // audible victim: oldest voice, slow 100 Hz slope
+  for (int v = 1; v < Mixer::MaxVoices; ++v)
+    m.trigger(100, 1000, 0, 0); // silent fillers so the next trigger must steal
+  m.render(buf, 1020);         // 1020 = quarter period + 4 periods: victim at its peak
+  int prev = buf[1019];
+  m.trigger(100, 1000, 0, 0);
+  m.render(buf, 1024);
+  int worst = 0;
+  for (int i = 0; i < 1024; ++i)
+  {
+    int d = buf[i] - prev;
+    worst = std::max(worst, d < 0 ? -d : d);
+    prev = buf[i];
+  }
+  return worst;
+}
+
+int main(int argc, char **argv)
+{
+  const char *wav_path = (argc > 1) ? argv[1] : "mixer_bench.wav";
+
+  // 1) Render a short clip for verification
+  AudioMixer mixer;
+  std::vector<int16_t> pcm;
+  int16_t block[BlockSamples];
+  render_demo(mixer, pcm);
+  int peak = 0;
+  size_t clipped = 0;
+  for (int16_t s : pcm)
+  {
+    int mag = s < 0 ? -(int)s : (int)s;
+    peak = std::max(peak, mag);
+    if (mag >= 32767)
+      clipped++;
+  }
+  if (!write_wav(wav_path, pcm))
+  {
+    fprintf(stderr, "[BENCH] cannot write %s\n", wav_path);
+    return 1;
+  }
+  printf("[BENCH] wrote %s: %zu samples (%.1f ms) peak=%d clipped=%zu\n", wav_path, pcm.size(),
+         pcm.size() * 1000.0 / Mixer::SampleRate, peak, clipped);
+  if (clipped)
+  {
+    fprintf(stderr, "[BENCH] FAIL: overlapping effects clip the mix\n");
+    return 1;
+  }
+  int step = steal_step();
+  printf("[BENCH] voice steal: max step=%d\n", step);
+  if (step > Mixer::TableAmp / 4)
+  {
+    fprintf(stderr, "[BENCH] FAIL: stolen voice cuts off without a fade\n");
+    return 1;
+  }
+
+  // 2) Time the kernel with every voice busy (worst case per block)
+  const int iters = 200000;
+  volatile int32_t sink = 0;
+  AudioMixer busy;
+  auto t0 = std::chrono::steady_clock::now();
+  for (int it = 0; it < iters; ++it)
+  {
+    if (!busy.active())
+      for (int v = 0; v < Mixer::MaxVoices; ++v)
+        busy.trigger((uint16_t)(600 + 300 * v), 1000);
+    busy.render(block, BlockSamples);
+    sink += block[it % BlockSamples];
+  }
+  auto t1 = std::chrono::steady_clock::now();
+  double ns_block = std::chrono::duration<double, std::nano>(t1 - t0).count() / iters;
+  double realtime = (BlockSamples * 1e9 / Mixer::SampleRate) / ns_block;
+  printf("[BENCH] %d voices: %.0f ns/block of %d samples (%.2f ns/sample, %.0fx realtime)\n",
+         Mixer::MaxVoices, ns_block, BlockSamples, ns_block / BlockSamples, realtime);
+  (void)sink;
+  return 0;
+}
@@ -0,0 +1,230 @@
+// Host simulation for the settings store in src/settings_store.h, using a file-backed NVS stand-in.
+// Replays bursts of encoder detents/theme presses, reports write counts and commit latency,
+// then "reboots" (fresh store on the same file) and checks the restore, a corrupted slot, input deferring
+// a commit, and a failing backend.
+//
+// Build/run on Linux:
+//   g++ -O2 -std=c++11 -Isrc tools/settings_sim.cpp -o settings_sim && ./settings_sim settings_sim.nvs
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <string>
+#include <vector>
+#include "settings_store.h"
+
+// All keys in one file: repeated [key\0][u32 len][bytes], rewritten on every write like an NVS page
+class FileSettingsBackend : public SettingsBackend
+{
+public:
+  explicit FileSettingsBackend(const char *path) : path_(path) { load(); }
+
+  bool read(const char *key, void *buf, size_t len) override
+  {
+    auto it = blobs_.find(key);
+    if (it == blobs_.end() || it->second.size() != len)
+      return false;
+    memcpy(buf, it->second.data(), len);
+    return true;
+  }
+
+  bool write(const char *key, const void *buf, size_t len) override
+  {
+    attempts_++;
+    if (fail_)
+      return false;
+    const uint8_t *p = (const uint8_t *)buf;
+    blobs_[key].assign(p, p + len);
+    writes_[key]++;
+    return save();
+  }
+
+  void corrupt(const char *key)
+  {
+    auto it = blobs_.find(key);
+    if (it != blobs_.end() && !it->second.empty())
+      it->second.back() ^= 0xFF;
+    save();
+  }
+
+  const std::map<std::string, uint32_t> &writes() const { return writes_; }
+  uint32_t attempts() const { return attempts_; }
+  void set_fail(bool fail) { fail_ = fail; }
+
+private:
+  void load()
+  {
+    FILE *f = fopen(path_.c_str(), "rb");
+    if (!f)
+      return;
+    std::string key;
+    int c;
+    while ((c = fgetc(f)) != EOF)
+    {
+      if (c)
+      {
+        key.push_back((char)c);
+        continue;
+      }
+      uint32_t len = 0;
+      if (fread(&len, 4, 1, f) != 1)
+        break;
+      std::vector<uint8_t> v(len);
+      if (len && fread(v.data(), 1, len, f) != len)
+        break;
+      blobs_[key] = v;
+      key.clear();
+    }
+    fclose(f);
+  }
+
+  bool save()
+  {
+    FILE *f = fopen(path_.c_str(), "wb");
+    if (!f)
+      return false;
+    for (const auto &kv : blobs_)
+    {
+      uint32_t len = (uint32_t)kv.second.size();
+      fwrite(kv.first.c_str(), 1, kv.first.size() + 1, f);
+      fwrite(&len, 4, 1, f);
+      fwrite(kv.second.data(), 1, len, f);
+    }
+    fflush(f);
+    fclose(f);
+    return true;
+  }
+
+  std::string path_;
+  std::map<std::string, std::vector<uint8_t>> blobs_;
+  std::map<std::string, uint32_t> writes_;
+  uint32_t attempts_ = 0;
+  bool fail_ = false;
+};
+
+static uint32_t host_clock_us()
+{
+  using namespace std::chrono;
+  return (uint32_t)duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+static int failures = 0;
+static void check(bool ok, const char *what)
+{
+  printf("[SIM] %-44s %s\n", what, ok ? "ok" : "FAIL");
+  if (!ok)
+    failures++;
+}
+
+int main(int argc, char **argv)
+{
+  const char *path = (argc > 1) ? argv[1] : "settings_sim.nvs";
+  remove(path);
+
+  Settings s = {80, 0, 0};
+  uint32_t now = 0;
+  {
+    FileSettingsBackend nvs(path);
+    SettingsStore store(nvs, host_clock_us);
+    check(!store.restore(s), "fresh store uses defaults");
+
+    // 50 bursts: 20 detents 30 ms apart, a theme press, then 3 s idle
+    for (int burst = 0; burst < 50; ++burst)
+    {
+      for (int d = 0; d < 20; ++d)
+      {
+        s.brightness_pct = (uint8_t)((s.brightness_pct + 10) % 110);
+        store.set(s, now);
+        store.service(now);
+        now += 30;
+      }
+      s.theme_idx = (uint8_t)((s.theme_idx + 1) % 6);
+      store.set(s, now);
+      for (int t = 0; t < 3000; t += 16)
+      {
+        store.service(now);
+        now += 16;
+      }
+    }
+    s.invert = 1;
+    store.set(s, now);
+    store.service(now + SettingsCfg::QuietMs);
+
+    const SettingsStats &st = store.stats();
+    printf("[SIM] changes=%lu commits=%lu failed=%lu last=%luus max=%luus\n",
+           (unsigned long)st.changes, (unsigned long)st.commits, (unsigned long)st.failed,
+           (unsigned long)st.last_commit_us, (unsigned long)st.max_commit_us);
+    for (const auto &kv : nvs.writes())
+      printf("[SIM]   %s: %lu writes\n", kv.first.c_str(), (unsigned long)kv.second);
+    check(st.commits == 51, "one commit per quiet period");
+    check(!store.dirty(), "nothing pending after final quiet period");
+  }
+
+  {
+    FileSettingsBackend nvs(path);
+    SettingsStore store(nvs, host_clock_us);
+    Settings r = {80, 0, 0};
+    bool found = store.restore(r);
+    check(found && r.brightness_pct == s.brightness_pct && r.theme_idx == s.theme_idx && r.invert == 1,
+          "reboot restores newest record");
+
+    // Newest record is seq 51 -> slot 51 % Slots; damage it and expect the previous one
+    char key[8];
+    snprintf(key, sizeof(key), "rec%d", 51 % SettingsCfg::Slots);
+    nvs.corrupt(key);
+  }
+
+  {
+    FileSettingsBackend nvs(path);
+    SettingsStore store(nvs, host_clock_us);
+    Settings r = {80, 0, 0};
+    bool found = store.restore(r);
+    check(found && r.invert == 0 && r.theme_idx == s.theme_idx, "corrupt slot falls back to previous record");
+  }
+
+  {
+    // Input after the last change (e.g. a drag after a theme press) holds the commit off until idle
+    FileSettingsBackend nvs(path);
+    SettingsStore store(nvs, host_clock_us);
+    Settings r = {80, 0, 0};
+    store.restore(r);
+    r.theme_idx = 3;
+    now = 0;
+    store.set(r, now);
+    bool early = false;
+    for (; now < 3 * SettingsCfg::QuietMs; now += 16)
+    {
+      if (now >= SettingsCfg::QuietMs / 2)
+        store.activity(now); // dragging from 1 s to 6 s
+      early |= store.service(now);
+    }
+    check(!early && store.dirty(), "input defers commit past the quiet period");
+    for (uint32_t end = now + SettingsCfg::QuietMs; now <= end; now += 16)
+      store.service(now);
+    check(!store.dirty() && store.stats().commits == 1, "commit lands once input stops");
+  }
+
+  {
+    // Failing flash: one attempt per quiet period, not one per loop pass
+    FileSettingsBackend nvs(path);
+    SettingsStore store(nvs, host_clock_us);
+    Settings r = {80, 0, 0};
+    store.restore(r);
+    nvs.set_fail(true);
+    r.brightness_pct = 30;
+    now = 0;
+    store.set(r, now);
+    for (; now < 10 * SettingsCfg::QuietMs; now += 16)
+      store.service(now);
+    printf("[SIM] failing backend: attempts=%lu failed=%lu over %lus\n", (unsigned long)nvs.attempts(),
+           (unsigned long)store.stats().failed, (unsigned long)(now / 1000));
+    check(nvs.attempts() <= 10 && store.stats().failed == nvs.attempts(), "failed write backs off a quiet period");
+    check(store.dirty() && store.stats().commits == 0, "failed write stays pending");
+
+    nvs.set_fail(false);
+    store.service(now + SettingsCfg::QuietMs);
+    check(!store.dirty() && store.stats().commits == 1, "write succeeds once backend recovers");
+  }
+
+  remove(path);
+  return failures ? 1 : 0;
+}